@@ -36,4 +36,22 @@ struct SimpleNode {
     }
 };
 
+// Estado de uma análise sintática. Cada compilação tem o seu, em vez de
+// globais (yyin, root, yylineno), o que torna o front end reentrante.
+struct ParseState {
+    SimpleNode* root = nullptr;
+    std::string errors;
+
+    ParseState() = default;
+    ParseState(const ParseState&) = delete;
+    ParseState& operator=(const ParseState&) = delete;
+
+    ~ParseState() {
+        delete root;
+    }
+};
+
+// Definido em lexer.l: analisa `source` e preenche state.root.
+bool parseBandLang(const std::string& source, ParseState& state);
+
 #endif // AST_HPP
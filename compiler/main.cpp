@@ -4,16 +4,23 @@
 #include <sstream>
 #include <map>
 #include <cmath>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
 #include "ast.hpp"
+#include "../vm/gbasm_binary.hpp"
 
-// Forward declarations from parser
-extern FILE* yyin;
-extern int yyparse();
-extern SimpleNode* root;
+// Estado de geração de código de uma compilação. Mantê-lo por compilação
+// garante labels determinísticos e permite compilar vários arquivos em paralelo.
+struct CodegenContext {
+    int loop_counter = 0;
+};
 
 // Pitch string to MIDI note conversion
 int pitchToMIDI(const std::string& pitch) {
-    static std::map<std::string, int> noteMap = {
+    static const std::map<std::string, int> noteMap = {
         {"C", 0}, {"C#", 1}, {"Db", 1}, {"D", 2}, {"D#", 3}, {"Eb", 3},
         {"E", 4}, {"F", 5}, {"F#", 6}, {"Gb", 6}, {"G", 7}, {"G#", 8}, 
         {"Ab", 8}, {"A", 9}, {"A#", 10}, {"Bb", 10}, {"B", 11}
@@ -24,9 +31,10 @@ int pitchToMIDI(const std::string& pitch) {
     std::string note = pitch.substr(0, pitch.length() - 1);
     int octave = std::stoi(pitch.substr(pitch.length() - 1));
     
-    if (noteMap.find(note) == noteMap.end()) return 60;
+    auto it = noteMap.find(note);
+    if (it == noteMap.end()) return 60;
     
-    return (octave + 1) * 12 + noteMap[note];
+    return (octave + 1) * 12 + it->second;
 }
 
 // Duration to ticks conversion (480 ticks per beat at any BPM)
@@ -62,7 +70,7 @@ int getDrumID(const std::string& drumType) {
 }
 
 // Generate GBASM from AST
-std::string generateGBASM(SimpleNode* node) {
+std::string generateGBASM(SimpleNode* node, CodegenContext& ctx) {
     if (!node) return "";
     
     std::string result;
@@ -86,7 +94,7 @@ std::string generateGBASM(SimpleNode* node) {
         // Process statements
         if (node->children.size() > 1 && node->children[1]->type == "statements") {
             for (auto stmt : node->children[1]->children) {
-                result += generateGBASM(stmt);
+                result += generateGBASM(stmt, ctx);
             }
         }
         
@@ -94,7 +102,7 @@ std::string generateGBASM(SimpleNode* node) {
         
     } else if (node->type == "statements") {
         for (auto stmt : node->children) {
-            result += generateGBASM(stmt);
+            result += generateGBASM(stmt, ctx);
         }
         
     } else if (node->type == "play_note") {
@@ -154,8 +162,7 @@ std::string generateGBASM(SimpleNode* node) {
         }
         
     } else if (node->type == "loop_stmt") {
-        static int loop_counter = 0;
-        std::string loop_label = "LOOP_" + std::to_string(loop_counter++);
+        std::string loop_label = "LOOP_" + std::to_string(ctx.loop_counter++);
         
         result += "; Loop statement\n";
         if (node->children.size() > 0 && node->children[0]->type == "number") {
@@ -228,48 +235,215 @@ std::string generateGBASM(SimpleNode* node) {
     return result;
 }
 
-int main(int argc, char* argv[]) {
-    if (argc != 4 || std::string(argv[2]) != "-o") {
-        std::cerr << "Uso: " << argv[0] << " <arquivo.band> -o <arquivo.gbasm>" << std::endl;
-        return 1;
+// Compila um arquivo .band para .gbasm (ou .gbc se `binary`). Mensagens vão
+// para `log` para que o modo paralelo possa imprimi-las na ordem de entrada.
+bool compileFile(const std::string& inputFile, const std::string& outputFile, bool binary, std::ostream& log) {
+    std::ifstream inFile(inputFile, std::ios::binary);
+    if (!inFile) {
+        log << "Erro: Não foi possível abrir " << inputFile << std::endl;
+        return false;
     }
     
-    std::string inputFile = argv[1];
-    std::string outputFile = argv[3];
+    std::ostringstream source;
+    source << inFile.rdbuf();
     
-    // Open input file
-    yyin = fopen(inputFile.c_str(), "r");
-    if (!yyin) {
-        std::cerr << "Erro: Não foi possível abrir " << inputFile << std::endl;
-        return 1;
+    log << "Compilando " << inputFile << " -> " << outputFile << std::endl;
+    
+    std::string output;
+    try {
+        // Parse
+        ParseState state;
+        bool parsed = parseBandLang(source.str(), state);
+        log << state.errors;
+        if (!parsed) {
+            log << "Erro: Falha na análise sintática" << std::endl;
+            return false;
+        }
+        
+        // Generate GBASM
+        CodegenContext ctx;
+        output = generateGBASM(state.root, ctx);
+        
+        // Assemble to the binary container if requested
+        if (binary) {
+            GbcProgram program;
+            std::string error;
+            if (!assembleGBASM(output, program, error)) {
+                log << "Erro: " << error << std::endl;
+                return false;
+            }
+            output = serializeGBC(program);
+        }
+    } catch (const std::exception& e) {
+        // Ex.: std::stoi em um pitch/duração malformado. No modo --jobs a
+        // exceção não pode escapar da thread (std::terminate).
+        log << "Erro: valor inválido em " << inputFile << " (" << e.what() << ")" << std::endl;
+        return false;
+    }
+    
+    // Write output
+    std::ofstream outFile(outputFile, std::ios::binary);
+    if (!outFile) {
+        log << "Erro: Não foi possível criar " << outputFile << std::endl;
+        return false;
     }
     
-    std::cout << "Compilando " << inputFile << " -> " << outputFile << std::endl;
+    outFile << output;
+    outFile.close();
     
-    // Parse
-    if (yyparse() != 0 || !root) {
-        std::cerr << "Erro: Falha na análise sintática" << std::endl;
-        fclose(yyin);
+    log << "✓ " << (binary ? "GBC" : "GBASM") << " gerado com sucesso: " << outputFile << std::endl;
+    return true;
+}
+
+// Converte um container .gbc de volta para texto GBASM
+int disassembleFile(const std::string& inputFile, const std::string& outputFile) {
+    std::ifstream inFile(inputFile, std::ios::binary);
+    if (!inFile) {
+        std::cerr << "Erro: Não foi possível abrir " << inputFile << std::endl;
         return 1;
     }
     
-    fclose(yyin);
+    std::ostringstream bytes;
+    bytes << inFile.rdbuf();
+    std::string data = bytes.str();
     
-    // Generate GBASM
-    std::string gbasm = generateGBASM(root);
+    GbcView view;
+    std::string error;
+    if (!openGBC(data.data(), data.size(), view, error)) {
+        std::cerr << "Erro: " << inputFile << ": " << error << std::endl;
+        return 1;
+    }
     
-    // Write output
     std::ofstream outFile(outputFile);
     if (!outFile) {
         std::cerr << "Erro: Não foi possível criar " << outputFile << std::endl;
         return 1;
     }
     
-    outFile << gbasm;
-    outFile.close();
+    outFile << disassembleGBC(view);
+    std::cout << "✓ GBASM desmontado: " << inputFile << " -> " << outputFile << std::endl;
+    return 0;
+}
+
+// Caminho de saída no modo --jobs: <dir>/<nome>.gbasm (ou .gbc)
+std::string outputPathFor(const std::string& inputFile, const std::string& outputDir, bool binary) {
+    std::string name = inputFile;
+    size_t slash = name.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : name.substr(0, slash);
+    if (slash != std::string::npos) name = name.substr(slash + 1);
     
-    std::cout << "✓ GBASM gerado com sucesso: " << outputFile << std::endl;
+    size_t dot = name.rfind(".band");
+    if (dot != std::string::npos && dot + 5 == name.size()) name = name.substr(0, dot);
     
-    delete root;
-    return 0;
+    return (outputDir.empty() ? dir : outputDir) + "/" + name + (binary ? ".gbc" : ".gbasm");
+}
+
+// Compila um catálogo de arquivos em paralelo com até `jobs` threads
+int compileBatch(const std::vector<std::string>& inputs, const std::string& outputDir, bool binary, int jobs) {
+    // Duas entradas com o mesmo nome base seriam escritas no mesmo arquivo
+    // ao mesmo tempo: recusa antes de compilar qualquer coisa
+    std::vector<std::string> outputs;
+    std::map<std::string, size_t> owner;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        outputs.push_back(outputPathFor(inputs[i], outputDir, binary));
+        auto inserted = owner.emplace(outputs[i], i);
+        if (!inserted.second) {
+            std::cerr << "Erro: " << inputs[inserted.first->second] << " e " << inputs[i]
+                      << " gerariam o mesmo arquivo " << outputs[i] << std::endl;
+            return 1;
+        }
+    }
+    
+    std::vector<std::ostringstream> logs(inputs.size());
+    std::vector<char> ok(inputs.size(), 0);
+    std::atomic<size_t> next{0};
+    
+    auto worker = [&]() {
+        for (size_t i = next++; i < inputs.size(); i = next++) {
+            ok[i] = compileFile(inputs[i], outputs[i], binary, logs[i]);
+        }
+    };
+    
+    int numThreads = std::max(1, std::min(jobs, static_cast<int>(inputs.size())));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    int failures = 0;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        (ok[i] ? std::cout : std::cerr) << logs[i].str();
+        if (!ok[i]) failures++;
+    }
+    
+    std::cout << "✓ " << inputs.size() - failures << "/" << inputs.size()
+              << " arquivos compilados com " << numThreads << " threads" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    // --binary pode aparecer em qualquer posição
+    bool binary = false;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--binary") {
+            binary = true;
+        } else {
+            args.push_back(arg);
+        }
+    }
+    
+    if (args.size() == 4 && args[0] == "--disasm" && args[2] == "-o") {
+        return disassembleFile(args[1], args[3]);
+    }
+    
+    if (args.size() >= 2 && args[0] == "--jobs") {
+        // 0 = todos os núcleos
+        char* end = nullptr;
+        long requested = std::strtol(args[1].c_str(), &end, 10);
+        if (args[1].empty() || *end != '\0' || requested < 0 || requested > 1024) {
+            std::cerr << "Erro: --jobs inválido: " << args[1] << " (use 0-1024)" << std::endl;
+            return 1;
+        }
+        int jobs = static_cast<int>(requested);
+        if (jobs == 0) jobs = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        
+        std::string outputDir;
+        std::vector<std::string> inputs;
+        for (size_t i = 2; i < args.size(); i++) {
+            if (args[i] == "-o" && i + 1 < args.size()) {
+                outputDir = args[++i];
+            } else {
+                inputs.push_back(args[i]);
+            }
+        }
+        
+        if (!inputs.empty()) {
+            return compileBatch(inputs, outputDir, binary, jobs);
+        }
+    }
+    
+    if (args.size() != 3 || args[1] != "-o") {
+        std::cerr << "Uso: " << argv[0] << " <arquivo.band> -o <arquivo.gbasm|arquivo.gbc> [--binary]" << std::endl;
+        std::cerr << "     " << argv[0] << " --jobs N [-o <diretório>] [--binary] <arquivo.band>..." << std::endl;
+        std::cerr << "     " << argv[0] << " --disasm <arquivo.gbc> -o <arquivo.gbasm>" << std::endl;
+        return 1;
+    }
+    
+    std::string inputFile = args[0];
+    std::string outputFile = args[2];
+    
+    // Saída .gbc implica o container binário
+    if (outputFile.size() > 4 && outputFile.compare(outputFile.size() - 4, 4, ".gbc") == 0) {
+        binary = true;
+    }
+    
+    std::ostringstream log;
+    bool ok = compileFile(inputFile, outputFile, binary, log);
+    (ok ? std::cout : std::cerr) << log.str();
+    return ok ? 0 : 1;
 }
@@ -1,3 +1,12 @@
+%code requires {
+#include "ast.hpp"
+
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void* yyscan_t;
+#endif
+}
+
 %{
 #include <iostream>
 #include <string>
@@ -5,16 +14,17 @@
 #include <memory>
 #include <cstdlib>
 #include "ast.hpp"
+%}
 
-// Forward declaration
-struct SimpleNode;
-
-extern int yylex();
-extern int yylineno;
-void yyerror(const char* s);
+%define api.pure full
+%lex-param { yyscan_t scanner }
+%parse-param { yyscan_t scanner } { ParseState* state }
 
-SimpleNode* root = nullptr;
-%}
+%code {
+int yylex(YYSTYPE* yylval_param, yyscan_t yyscanner);
+int yyget_lineno(yyscan_t yyscanner);
+void yyerror(yyscan_t scanner, ParseState* state, const char* s);
+}
 
 %union {
     double number;
@@ -66,7 +76,7 @@ program:
         $$->addChild($1);
         $$->addChild($2);
         $$->addChild($3);
-        root = $$;
+        state->root = $$;
     }
     ;
 
@@ -326,6 +336,6 @@ primary_expression:
 
 %%
 
-void yyerror(const char* s) {
-    std::cerr << "Erro na linha " << yylineno << ": " << s << std::endl;
+void yyerror(yyscan_t scanner, ParseState* state, const char* s) {
+    state->errors += "Erro na linha " + std::to_string(yyget_lineno(scanner)) + ": " + s + "\n";
 }
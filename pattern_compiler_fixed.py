@@ -6,6 +6,108 @@ Corrige as pausas estranhas no sistema de patterns
 
 import sys
 import re
+import struct
+
+# Container binário GBC (ver vm/gbasm_binary.hpp)
+GBC_MAGIC = b"GBBC"
+GBC_VERSION = 2
+GBC_MAX_CHORD_NOTES = 4    # notas por instrução
+GBC_MAX_CHORD_SIZE = 1024  # notas por acorde (com continuações)
+GBC_OPCODES = {
+    "NOP": 0, "SET_TEMPO": 1, "SET_TS": 2, "TRACK": 3, "NOTE": 4, "CHORD": 5,
+    "DRUM": 6, "WAIT": 7, "LOAD": 8, "DECJNZ": 9, "JMP": 10, "HALT": 11,
+}
+GBC_CHORD_CONT = 12
+
+def gbc_operand(text, line):
+    """Operando int32, como o `int` da VM de texto"""
+    value = int(text)
+    if not -2**31 <= value < 2**31:
+        raise ValueError(f"GBASM operand out of range: {line}")
+    return value
+
+def assemble_gbc(gbasm):
+    """Monta texto GBASM no container binário .gbc"""
+    lines, label_lines = [], []
+    for raw in gbasm.split('\n'):
+        line = raw.split(';', 1)[0].strip()
+        if not line:
+            continue
+        if line.startswith(':'):
+            label_lines.append((line[1:], len(lines)))
+            continue
+        lines.append(line)
+
+    # Acordes com mais de GBC_MAX_CHORD_NOTES notas ocupam instruções CHORD_CONT extras
+    code_index = [0]
+    for line in lines:
+        parts = line.split()
+        size = 1
+        if parts[0] == "CHORD":
+            count = min(gbc_operand(parts[1], line), GBC_MAX_CHORD_SIZE)
+            size = max(1, (count + GBC_MAX_CHORD_NOTES - 1) // GBC_MAX_CHORD_NOTES)
+        code_index.append(code_index[-1] + size)
+
+    labels, label_index = [], {}
+    for name, line_number in label_lines:
+        target = code_index[line_number]
+        label_index[name] = target
+        encoded = name.encode()
+        if len(encoded) >= 28:
+            encoded = encoded[:16] + b"~" + str(target).encode()
+        labels.append(struct.pack('<I28s', target, encoded))
+
+    tempo, code = [], []
+    for line in lines:
+        parts = line.replace('/', ' ').split()
+        cmd, args = parts[0], parts[1:]
+        num = lambda i: gbc_operand(args[i], line)
+        opcode = GBC_OPCODES.get(cmd, 0)
+        a = b = value = 0
+        notes = []
+
+        if cmd == "SET_TEMPO":
+            value = num(0)
+            tempo.append(struct.pack('<Iiii', len(code), value, 0, 0))
+        elif cmd == "SET_TS":
+            a, b = num(0), num(1)
+            tempo.append(struct.pack('<Iiii', len(code), 0, a, b))
+        elif cmd == "TRACK":
+            a = num(0)
+        elif cmd in ("NOTE", "DRUM"):
+            a, b, value = num(0), num(1), num(2)
+        elif cmd == "CHORD":
+            count = num(0)
+            if count > GBC_MAX_CHORD_SIZE:
+                raise ValueError(f"CHORD with more than {GBC_MAX_CHORD_SIZE} notes: {line}")
+            count = max(0, count)
+            pitches = [num(1 + i) for i in range(count)]
+            b, value = num(1 + count), num(2 + count)
+            for i in range(0, max(1, len(pitches)), GBC_MAX_CHORD_NOTES):
+                chunk = pitches[i:i + GBC_MAX_CHORD_NOTES]
+                more = 1 if i + GBC_MAX_CHORD_NOTES < len(pitches) else 0
+                padded = chunk + [0] * (GBC_MAX_CHORD_NOTES - len(chunk))
+                if i == 0:
+                    code.append(struct.pack('<BBHiii4i', opcode, more, 0, len(chunk), b, value, *padded))
+                else:
+                    code.append(struct.pack('<BBHiii4i', GBC_CHORD_CONT, more, 0, len(chunk), 0, 0, *padded))
+            continue
+        elif cmd == "WAIT":
+            value = num(0)
+        elif cmd in ("LOAD", "DECJNZ"):
+            if not re.fullmatch(r"R[0-3]", args[0]):
+                opcode = 0
+            else:
+                a = int(args[0][1])
+                value = num(1) if cmd == "LOAD" else label_index.get(args[1], -1)
+        elif cmd == "JMP":
+            value = label_index.get(args[0], -1)
+
+        notes += [0] * (GBC_MAX_CHORD_NOTES - len(notes))
+        code.append(struct.pack('<BBHiii4i', opcode, 0, 0, a, b, value, *notes))
+
+    header = struct.pack('<4sHHIIII', GBC_MAGIC, GBC_VERSION, 24, len(tempo), len(labels), len(code), 0)
+    return header + b''.join(tempo) + b''.join(labels) + b''.join(code)
 
 class PatternCompilerFixed:
     def __init__(self):
@@ -378,12 +480,14 @@ class PatternCompilerFixed:
         return gbasm
 
 def main():
-    if len(sys.argv) != 3:
-        print("Usage: python pattern_compiler_fixed.py <input.band> <output.gbasm>")
+    args = [arg for arg in sys.argv[1:] if arg != "--binary"]
+    if len(args) != 2:
+        print("Usage: python pattern_compiler_fixed.py <input.band> <output.gbasm|output.gbc> [--binary]")
         sys.exit(1)
     
-    input_file = sys.argv[1]
-    output_file = sys.argv[2]
+    input_file = args[0]
+    output_file = args[1]
+    binary = "--binary" in sys.argv or output_file.endswith(".gbc")
     
     try:
         with open(input_file, 'r', encoding='utf-8') as f:
@@ -392,8 +496,12 @@ def main():
         compiler = PatternCompilerFixed()
         gbasm = compiler.compile_bandlang(content)
         
-        with open(output_file, 'w') as f:
-            f.write(gbasm)
+        if binary:
+            with open(output_file, 'wb') as f:
+                f.write(assemble_gbc(gbasm))
+        else:
+            with open(output_file, 'w') as f:
+                f.write(gbasm)
         
         print(f"✓ FIXED Pattern compilation: {input_file} -> {output_file}")
         print(f"✓ BPM: {compiler.current_bpm}")
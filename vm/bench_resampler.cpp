@@ -0,0 +1,131 @@
+// Benchmark: throughput do resampler polifásico (frames de entrada/s)
+// e rejeição de stopband para cada razão de conversão e nível de qualidade.
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include "resampler.hpp"
+
+// Tom de teste na região que o filtro precisa remover: acima de Nyquist
+// da saída na decimação, perto de Nyquist da entrada na interpolação
+// (a imagem espelhada é o que deve sumir)
+double stopbandTone(int from, int to) {
+    if (to < from) return std::min(1.15 * to / 2.0, (to / 2.0 + from / 2.0) / 2.0);
+    return 0.8 * from / 2.0;
+}
+
+// Nível (dB relativo ao tom de entrada) de tudo que não é o tom desejado
+double stopbandLevel(int from, int to, ResamplerQuality quality) {
+    double tone = stopbandTone(from, to);
+    std::vector<float> input(from); // 1 s
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * tone * i / from));
+    }
+
+    PolyphaseResampler resampler(from, to, quality);
+    std::vector<float> output;
+    resampler.process(input.data(), input.size(), output);
+    resampler.finish(output);
+
+    // Ignora as bordas (transiente do filtro)
+    size_t begin = output.size() / 8, end = output.size() - output.size() / 8;
+    double ss = 0.0, sc = 0.0, cc = 0.0, ys = 0.0, yc = 0.0;
+    if (tone < to / 2.0) {
+        // O tom passa: remove-o por mínimos quadrados (seno + cosseno)
+        for (size_t n = begin; n < end; n++) {
+            double s = std::sin(2.0 * M_PI * tone * n / to), c = std::cos(2.0 * M_PI * tone * n / to);
+            ss += s * s; sc += s * c; cc += c * c;
+            ys += output[n] * s; yc += output[n] * c;
+        }
+    }
+    double det = ss * cc - sc * sc;
+    double a = det > 0.0 ? (ys * cc - yc * sc) / det : 0.0;
+    double b = det > 0.0 ? (yc * ss - ys * sc) / det : 0.0;
+
+    double residual = 0.0;
+    for (size_t n = begin; n < end; n++) {
+        double wanted = a * std::sin(2.0 * M_PI * tone * n / to) + b * std::cos(2.0 * M_PI * tone * n / to);
+        residual += (output[n] - wanted) * (output[n] - wanted);
+    }
+    double rms = std::sqrt(residual / (end - begin));
+    return 20.0 * std::log10(rms / (0.5 / std::sqrt(2.0)) + 1e-12);
+}
+
+int main() {
+    struct Conversion { int from; int to; const char* label; };
+    const Conversion conversions[] = {
+        {44100, 48000, "44.1k -> 48k"},
+        {48000, 44100, "48k -> 44.1k"},
+        {44100, 96000, "44.1k -> 96k"},
+        {88200, 44100, "2x decimate"},
+        {176400, 44100, "4x decimate"},
+        {176400, 48000, "4x -> 48k"},
+        {192000, 96000, "2x -> 96k"},
+        {44100, 47999, "44.1k -> 47999"},   // L > MAX_PHASES: fases interpoladas
+    };
+    const std::pair<ResamplerQuality, const char*> qualities[] = {
+        {ResamplerQuality::Fast, "fast"},
+        {ResamplerQuality::Standard, "standard"},
+        {ResamplerQuality::High, "high"},
+    };
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    std::vector<float> input(1 << 20);
+    for (auto& v : input) v = noise(rng);
+
+#if defined(__AVX__)
+    const char* simd = "AVX";
+#elif defined(__SSE__)
+    const char* simd = "SSE";
+#else
+    const char* simd = "scalar";
+#endif
+    std::cout << "Polyphase resampler throughput (" << input.size() << " input frames, " << simd << ")" << std::endl;
+    std::cout << std::setw(16) << "conversion" << std::setw(12) << "L/M";
+    for (const auto& q : qualities) std::cout << std::setw(16) << q.second;
+    std::cout << "   (Mframes/s in)" << std::endl;
+
+    for (const auto& c : conversions) {
+        PolyphaseResampler probe(c.from, c.to);
+        std::cout << std::setw(16) << c.label << std::setw(12)
+                  << (std::to_string(probe.upFactor()) + "/" + std::to_string(probe.downFactor()));
+
+        for (const auto& q : qualities) {
+            PolyphaseResampler resampler(c.from, c.to, q.first);
+            std::vector<float> output;
+            output.reserve(input.size() * 3);
+
+            auto start = std::chrono::steady_clock::now();
+            for (size_t offset = 0; offset < input.size(); offset += 512) {
+                resampler.process(input.data() + offset, std::min<size_t>(512, input.size() - offset), output);
+            }
+            resampler.finish(output);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::cout << std::setw(16) << std::fixed << std::setprecision(1) << input.size() / seconds / 1e6;
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << std::endl << "Stopband rejection (aliasing/images relative to a full-level tone)" << std::endl;
+    std::cout << std::setw(16) << "conversion" << std::setw(12) << "tone";
+    for (const auto& q : qualities) std::cout << std::setw(16) << q.second;
+    std::cout << "   (dB)" << std::endl;
+
+    for (const auto& c : conversions) {
+        std::ostringstream tone;
+        tone << std::fixed << std::setprecision(1) << stopbandTone(c.from, c.to) / 1000.0 << "k";
+        std::cout << std::setw(16) << c.label << std::setw(12) << tone.str();
+        for (const auto& q : qualities) {
+            std::cout << std::setw(16) << std::fixed << std::setprecision(1) << stopbandLevel(c.from, c.to, q.first);
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,389 @@
+#ifndef EFFECTS_HPP
+#define EFFECTS_HPP
+
+// Estágio de efeitos do master bus: sends por track para um reverb de
+// convolução particionada (FFT), delay e limiter com look-ahead.
+// Tudo processa em blocos de tamanho fixo.
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <iostream>
+#include <string>
+#include <complex>
+#include <fstream>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include "resampler.hpp"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// FFT complexa radix-2 iterativa com tabelas pré-calculadas
+class FFT {
+private:
+    int size;
+    std::vector<int> bit_reverse;
+    std::vector<std::complex<float>> twiddles;
+
+public:
+    explicit FFT(int n) : size(n), bit_reverse(n), twiddles(n / 2) {
+        int bits = 0;
+        while ((1 << bits) < n) bits++;
+        for (int i = 0; i < n; i++) {
+            int r = 0;
+            for (int b = 0; b < bits; b++) {
+                if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+            }
+            bit_reverse[i] = r;
+        }
+        for (int i = 0; i < n / 2; i++) {
+            twiddles[i] = std::polar(1.0f, static_cast<float>(-2.0 * M_PI * i / n));
+        }
+    }
+
+    // Transformada in-place; a inversa não é normalizada (divida por size)
+    void transform(std::vector<std::complex<float>>& data, bool inverse) const {
+        for (int i = 0; i < size; i++) {
+            if (i < bit_reverse[i]) std::swap(data[i], data[bit_reverse[i]]);
+        }
+        for (int len = 2; len <= size; len <<= 1) {
+            int half = len / 2;
+            int step = size / len;
+            for (int start = 0; start < size; start += len) {
+                for (int k = 0; k < half; k++) {
+                    // Multiplicação complexa explícita (evita __mulsc3 sem -ffast-math)
+                    float wr = twiddles[k * step].real();
+                    float wi = inverse ? -twiddles[k * step].imag() : twiddles[k * step].imag();
+                    std::complex<float>& even = data[start + k];
+                    std::complex<float>& odd = data[start + k + half];
+                    float tr = wr * odd.real() - wi * odd.imag();
+                    float ti = wr * odd.imag() + wi * odd.real();
+                    odd = std::complex<float>(even.real() - tr, even.imag() - ti);
+                    even = std::complex<float>(even.real() + tr, even.imag() + ti);
+                }
+            }
+        }
+    }
+};
+
+// Convolução uniformemente particionada (overlap-save, delay line no
+// domínio da frequência). Latência zero: a saída do bloco corresponde
+// à entrada do mesmo bloco.
+class PartitionedConvolver {
+private:
+    int block_size;
+    int fft_size;
+    int num_partitions;
+    FFT fft;
+    std::vector<std::vector<std::complex<float>>> ir_spectra;  // H[p]
+    std::vector<std::vector<std::complex<float>>> input_spectra; // X[k - p], ring
+    int ring_pos = 0;
+    std::vector<float> previous_block;
+    std::vector<std::complex<float>> work;
+    std::vector<std::complex<float>> accumulator;
+
+public:
+    PartitionedConvolver(const std::vector<float>& impulse_response, int block)
+        : block_size(block), fft_size(2 * block),
+          num_partitions(std::max<int>(1, (impulse_response.size() + block - 1) / block)),
+          fft(2 * block),
+          ir_spectra(num_partitions, std::vector<std::complex<float>>(2 * block)),
+          input_spectra(num_partitions, std::vector<std::complex<float>>(2 * block)),
+          previous_block(block, 0.0f), work(2 * block), accumulator(2 * block) {
+        for (int p = 0; p < num_partitions; p++) {
+            auto& h = ir_spectra[p];
+            for (int i = 0; i < block_size; i++) {
+                size_t idx = static_cast<size_t>(p) * block_size + i;
+                h[i] = idx < impulse_response.size() ? impulse_response[idx] : 0.0f;
+            }
+            fft.transform(h, false);
+        }
+    }
+
+    // Processa exatamente block_size amostras
+    void process(const float* input, float* output) {
+        // Janela deslizante [bloco anterior | bloco atual]
+        for (int i = 0; i < block_size; i++) {
+            work[i] = previous_block[i];
+            work[block_size + i] = input[i];
+        }
+        std::copy(input, input + block_size, previous_block.begin());
+
+        ring_pos = (ring_pos + num_partitions - 1) % num_partitions;
+        fft.transform(work, false);
+        input_spectra[ring_pos] = work;
+
+        // Entrada e IR são reais: o espectro é hermitiano, então basta
+        // acumular os bins 0..N/2 e espelhar o restante
+        int bins = fft_size / 2 + 1;
+        std::fill(accumulator.begin(), accumulator.end(), std::complex<float>(0.0f, 0.0f));
+        float* acc = reinterpret_cast<float*>(accumulator.data());
+        for (int p = 0; p < num_partitions; p++) {
+            const float* x = reinterpret_cast<const float*>(input_spectra[(ring_pos + p) % num_partitions].data());
+            const float* h = reinterpret_cast<const float*>(ir_spectra[p].data());
+            for (int k = 0; k < 2 * bins; k += 2) {
+                acc[k] += x[k] * h[k] - x[k + 1] * h[k + 1];
+                acc[k + 1] += x[k] * h[k + 1] + x[k + 1] * h[k];
+            }
+        }
+        for (int k = bins; k < fft_size; k++) {
+            accumulator[k] = std::conj(accumulator[fft_size - k]);
+        }
+
+        fft.transform(accumulator, true);
+        float scale = 1.0f / fft_size;
+        for (int i = 0; i < block_size; i++) {
+            output[i] = accumulator[block_size + i].real() * scale;
+        }
+    }
+};
+
+// Delay com feedback (insert no master)
+class DelayLine {
+private:
+    std::vector<float> buffer;
+    size_t position = 0;
+    float feedback;
+    float mix;
+
+public:
+    DelayLine(int delay_samples, float fb, float wet)
+        : buffer(std::max(1, delay_samples), 0.0f), feedback(fb), mix(wet) {}
+
+    void process(float* data, int count) {
+        for (int i = 0; i < count; i++) {
+            float delayed = buffer[position];
+            buffer[position] = data[i] + delayed * feedback;
+            position = (position + 1) % buffer.size();
+            data[i] += delayed * mix;
+        }
+    }
+};
+
+// Limiter com look-ahead: min-hold do ganho necessário sobre a janela,
+// release exponencial e suavização por média móvel da mesma largura.
+// A saída fica atrasada em latency() amostras.
+class LookaheadLimiter {
+private:
+    float ceiling;
+    int window;
+    double release_coeff;
+    double gain = 1.0;
+    std::deque<std::pair<long, double>> hold; // fila monotônica (índice, ganho)
+    std::vector<double> smoothing;
+    double smoothing_sum;
+    std::vector<float> delay;
+    long counter = 0;
+
+public:
+    LookaheadLimiter(int sample_rate, float ceiling_level, double lookahead_ms = 5.0, double release_ms = 80.0)
+        : ceiling(ceiling_level),
+          window(std::max(1, static_cast<int>(sample_rate * lookahead_ms / 1000.0))),
+          release_coeff(1.0 - std::exp(-1.0 / (sample_rate * release_ms / 1000.0))),
+          smoothing(window, 1.0), smoothing_sum(window), delay(window, 0.0f) {}
+
+    int latency() const { return window - 1; }
+
+    void process(float* data, int count) {
+        for (int i = 0; i < count; i++) {
+            float x = data[i];
+            double required = std::fabs(x) > ceiling ? ceiling / std::fabs(x) : 1.0;
+
+            // Mínimo deslizante dos ganhos necessários
+            while (!hold.empty() && hold.back().second >= required) hold.pop_back();
+            hold.emplace_back(counter, required);
+            while (hold.front().first <= counter - window) hold.pop_front();
+            double target = hold.front().second;
+
+            // Ataque imediato, release exponencial
+            gain = target < gain ? target : gain + (target - gain) * release_coeff;
+
+            int slot = counter % window;
+            smoothing_sum += gain - smoothing[slot];
+            smoothing[slot] = gain;
+
+            delay[slot] = x;
+            float delayed = delay[(counter + 1) % window]; // entrada de window-1 amostras atrás
+            data[i] = static_cast<float>(delayed * std::min(1.0, smoothing_sum / window));
+            counter++;
+        }
+    }
+};
+
+// Lê o primeiro canal de um WAV PCM 16-bit ou float 32-bit
+inline bool loadImpulseResponse(const std::string& filename, std::vector<float>& ir, int& file_rate) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) return false;
+
+    char riff[12];
+    if (!file.read(riff, 12) || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    uint16_t format = 0, channels = 0, bits = 0;
+    uint32_t rate = 0;
+    char id[4];
+    uint32_t chunk_size;
+    while (file.read(id, 4) && file.read(reinterpret_cast<char*>(&chunk_size), 4)) {
+        if (std::memcmp(id, "fmt ", 4) == 0) {
+            // PCM/float precisa de pelo menos 16 bytes de fmt
+            if (chunk_size < 16) return false;
+            std::vector<char> fmt(chunk_size + (chunk_size & 1));
+            if (!file.read(fmt.data(), fmt.size())) return false;
+            std::memcpy(&format, &fmt[0], 2);
+            std::memcpy(&channels, &fmt[2], 2);
+            std::memcpy(&rate, &fmt[4], 4);
+            std::memcpy(&bits, &fmt[14], 2);
+        } else if (std::memcmp(id, "data", 4) == 0) {
+            if (channels == 0 || rate == 0 || !((format == 1 && bits == 16) || (format == 3 && bits == 32))) return false;
+            std::vector<char> data(chunk_size);
+            file.read(data.data(), chunk_size);
+            size_t frame_bytes = channels * bits / 8;
+            size_t frames = chunk_size / frame_bytes;
+            ir.resize(frames);
+            for (size_t f = 0; f < frames; f++) {
+                if (format == 1) {
+                    int16_t v;
+                    std::memcpy(&v, &data[f * frame_bytes], 2);
+                    ir[f] = v / 32768.0f;
+                } else {
+                    std::memcpy(&ir[f], &data[f * frame_bytes], 4);
+                }
+            }
+            file_rate = rate;
+            return !ir.empty();
+        } else {
+            file.seekg(chunk_size + (chunk_size & 1), std::ios::cur);
+        }
+    }
+    return false;
+}
+
+// IR sintética: ruído com decay exponencial (RT60) e leve passa-baixa
+inline std::vector<float> generateImpulseResponse(int sample_rate, double rt60_seconds) {
+    std::vector<float> ir(static_cast<size_t>(sample_rate * rt60_seconds));
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    double decay = std::exp(-6.9078 / (sample_rate * rt60_seconds)); // -60 dB em rt60
+    double envelope = 1.0, lowpass = 0.0;
+    for (auto& sample : ir) {
+        lowpass += (noise(rng) - lowpass) * 0.35;
+        sample = static_cast<float>(lowpass * envelope);
+        envelope *= decay;
+    }
+    return ir;
+}
+
+// Configuração do master bus (vinda da linha de comando da VM)
+struct MasterBusConfig {
+    std::vector<float> sends = {0.0f, 0.0f, 0.0f}; // reverb send por track
+    std::string ir_file;              // vazio = IR gerada
+    double reverb_time = 1.8;         // RT60 da IR gerada (s)
+    double delay_ms = 0.0;            // 0 = delay desligado
+    float delay_feedback = 0.35f;
+    float delay_mix = 0.3f;
+    float master_gain = 0.56f;
+    float ceiling = 0.8f;             // pico máximo de saída
+
+    bool reverbEnabled() const {
+        for (float s : sends) if (s > 0.0f) return true;
+        return false;
+    }
+};
+
+// Soma as tracks, aplica sends/reverb, delay e limiter bloco a bloco
+class MasterBus {
+public:
+    static const int BLOCK_SIZE = 512;
+    static constexpr double MAX_TAIL_SECONDS = 30.0; // teto da cauda do delay
+
+private:
+    MasterBusConfig config;
+    std::unique_ptr<PartitionedConvolver> reverb;
+    std::unique_ptr<DelayLine> delay;
+    LookaheadLimiter limiter;
+    int reverb_tail = 0;
+    int delay_tail = 0;
+
+public:
+    MasterBus(const MasterBusConfig& cfg, int sample_rate)
+        : config(cfg), limiter(sample_rate, cfg.ceiling) {
+        if (config.reverbEnabled()) {
+            std::vector<float> ir;
+            int ir_rate = sample_rate;
+            if (config.ir_file.empty() || !loadImpulseResponse(config.ir_file, ir, ir_rate)) {
+                if (!config.ir_file.empty()) {
+                    std::cerr << "Warning: could not load IR " << config.ir_file << ", using generated IR" << std::endl;
+                }
+                ir = generateImpulseResponse(sample_rate, config.reverb_time);
+            } else if (ir_rate != sample_rate) {
+                // Converte a IR para a taxa do bus
+                PolyphaseResampler resampler(ir_rate, sample_rate, ResamplerQuality::High);
+                std::vector<float> converted;
+                resampler.process(ir.data(), ir.size(), converted);
+                resampler.finish(converted);
+                ir.swap(converted);
+            }
+
+            // Normaliza energia da IR para que o send controle o nível do wet
+            double energy = 0.0;
+            for (float v : ir) energy += v * v;
+            float norm = energy > 0.0 ? static_cast<float>(1.0 / std::sqrt(energy)) : 1.0f;
+            for (float& v : ir) v *= norm;
+
+            reverb.reset(new PartitionedConvolver(ir, BLOCK_SIZE));
+            reverb_tail = ir.size();
+        }
+        if (config.delay_ms > 0.0) {
+            int delay_samples = static_cast<int>(sample_rate * config.delay_ms / 1000.0);
+            delay.reset(new DelayLine(delay_samples, config.delay_feedback, config.delay_mix));
+
+            // Primeiro eco + repetições até cair 60 dB; limitado como a IR
+            double repeats = 1.0;
+            if (config.delay_feedback > 0.0f) {
+                repeats += std::ceil(std::log(1e-3) / std::log(std::min(config.delay_feedback, 0.9999f)));
+            }
+            double max_tail = MAX_TAIL_SECONDS * sample_rate;
+            delay_tail = static_cast<int>(std::min(std::max(1, delay_samples) * repeats, max_tail));
+        }
+    }
+
+    // Amostras extras após o fim das tracks (cauda do reverb seguida da do delay)
+    int tailSamples() const { return reverb_tail + delay_tail; }
+    int latency() const { return limiter.latency(); }
+
+    // Mixa `count` amostras (count <= BLOCK_SIZE) a partir de `offset`
+    void process(const std::vector<std::vector<float>>& tracks, size_t offset, int count, float* out) {
+        float send_bus[BLOCK_SIZE] = {0.0f};
+        std::fill(out, out + count, 0.0f);
+
+        for (size_t t = 0; t < tracks.size(); t++) {
+            const auto& track = tracks[t];
+            float send = t < config.sends.size() ? config.sends[t] : 0.0f;
+            size_t end = std::min(track.size(), offset + count);
+            for (size_t i = offset; i < end; i++) {
+                out[i - offset] += track[i];
+                send_bus[i - offset] += track[i] * send;
+            }
+        }
+
+        if (reverb) {
+            float wet[BLOCK_SIZE];
+            reverb->process(send_bus, wet);
+            for (int i = 0; i < count; i++) out[i] += wet[i];
+        }
+        if (delay) {
+            delay->process(out, count);
+        }
+
+        for (int i = 0; i < count; i++) out[i] *= config.master_gain;
+        limiter.process(out, count);
+    }
+};
+
+#endif // EFFECTS_HPP
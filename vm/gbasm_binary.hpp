@@ -0,0 +1,524 @@
+#ifndef GBASM_BINARY_HPP
+#define GBASM_BINARY_HPP
+
+// Container binário pré-compilado de GBASM (.gbc)
+//
+// Layout (little-endian, seções contíguas após o header):
+//   GbcHeader
+//   GbcTempoEntry[tempo_count]       - mudanças de tempo/compasso
+//   GbcLabel[label_count]            - labels já resolvidos (para disassembly)
+//   GbcInstruction[instruction_count] - instruções de largura fixa
+//
+// Saltos (JMP/DECJNZ) guardam o índice da instrução destino, então a VM
+// executa o array diretamente, sem tokenizar nem resolver labels.
+
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+
+enum GbcOpcode : uint8_t {
+    GBC_NOP = 0,
+    GBC_SET_TEMPO,
+    GBC_SET_TS,
+    GBC_TRACK,
+    GBC_NOTE,
+    GBC_CHORD,
+    GBC_DRUM,
+    GBC_WAIT,
+    GBC_LOAD,
+    GBC_DECJNZ,
+    GBC_JMP,
+    GBC_HALT,
+    GBC_CHORD_CONT
+};
+
+static const char GBC_MAGIC[4] = {'G', 'B', 'B', 'C'};
+static const uint16_t GBC_VERSION = 2;
+static const int GBC_MAX_CHORD_NOTES = 4;    // notas por instrução
+static const int GBC_MAX_CHORD_SIZE = 1024;  // notas por acorde (com continuações)
+
+struct GbcHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t tempo_count;
+    uint32_t label_count;
+    uint32_t instruction_count;
+    uint32_t reserved;
+};
+
+struct GbcTempoEntry {
+    uint32_t instruction_index;
+    int32_t bpm;           // 0 = sem mudança de tempo
+    int32_t ts_numerator;  // 0 = sem mudança de compasso
+    int32_t ts_denominator;
+};
+
+struct GbcLabel {
+    uint32_t target;
+    char name[28];
+};
+
+// Operandos têm a largura do `int` da VM de texto (int32), então nenhum
+// programa de texto perde valores ao passar pelo assembler.
+// Operandos por opcode:
+//   SET_TEMPO: value=bpm            SET_TS: a=numerador, b=denominador
+//   TRACK:     a=track              WAIT:   value=ticks
+//   NOTE:      a=pitch, b=velocity, value=duração
+//   CHORD:     a=n notas, b=velocity, value=duração, notes[0..n)
+//              reserved=1: as notas continuam na próxima instrução
+//   CHORD_CONT: a=n notas, notes[0..n), reserved=1 se houver outra
+//              (acordes com mais de GBC_MAX_CHORD_NOTES notas)
+//   DRUM:      a=tipo, b=velocity, value=duração
+//   LOAD:      a=registrador, value=valor
+//   DECJNZ:    a=registrador, value=destino (-1 = label desconhecido)
+//   JMP:       value=destino
+struct GbcInstruction {
+    uint8_t opcode;
+    uint8_t reserved;
+    uint16_t padding;
+    int32_t a;
+    int32_t b;
+    int32_t value;
+    int32_t notes[GBC_MAX_CHORD_NOTES];
+};
+
+static_assert(sizeof(GbcHeader) == 24, "GbcHeader deve ter 24 bytes");
+static_assert(sizeof(GbcTempoEntry) == 16, "GbcTempoEntry deve ter 16 bytes");
+static_assert(sizeof(GbcLabel) == 32, "GbcLabel deve ter 32 bytes");
+static_assert(sizeof(GbcInstruction) == 32, "GbcInstruction deve ter 32 bytes");
+
+// Programa montado em memória (saída do assembler)
+struct GbcProgram {
+    std::vector<GbcTempoEntry> tempo;
+    std::vector<GbcLabel> labels;
+    std::vector<GbcInstruction> code;
+};
+
+// Visão somente-leitura sobre um container (ex.: arquivo mapeado em memória)
+struct GbcView {
+    const GbcHeader* header = nullptr;
+    const GbcTempoEntry* tempo = nullptr;
+    const GbcLabel* labels = nullptr;
+    const GbcInstruction* code = nullptr;
+    uint32_t tempo_count = 0;
+    uint32_t label_count = 0;
+    uint32_t instruction_count = 0;
+};
+
+inline GbcView viewOf(const GbcProgram& program) {
+    GbcView view;
+    view.tempo = program.tempo.data();
+    view.labels = program.labels.data();
+    view.code = program.code.data();
+    view.tempo_count = program.tempo.size();
+    view.label_count = program.labels.size();
+    view.instruction_count = program.code.size();
+    return view;
+}
+
+inline bool isGBC(const void* data, size_t size) {
+    return size >= sizeof(GbcHeader) && std::memcmp(data, GBC_MAGIC, 4) == 0;
+}
+
+inline int gbcRegister(const std::string& reg) {
+    if (reg.size() != 2 || reg[0] != 'R' || reg[1] < '0' || reg[1] > '3') return -1;
+    return reg[1] - '0';
+}
+
+// Quantas instruções binárias uma linha de texto ocupa
+// (tokeniza como o encoder, então "CHORD\t9 ..." conta igual)
+inline int gbcEncodedSize(const std::string& line) {
+    std::istringstream iss(line);
+    std::string cmd;
+    int num_notes = 0;
+    iss >> cmd >> num_notes;
+    if (cmd != "CHORD" || num_notes <= GBC_MAX_CHORD_NOTES) return 1;
+    num_notes = std::min(num_notes, GBC_MAX_CHORD_SIZE);
+    return (num_notes + GBC_MAX_CHORD_NOTES - 1) / GBC_MAX_CHORD_NOTES;
+}
+
+// Monta texto GBASM em um GbcProgram. Aceita todo programa que a VM de
+// texto lia com operandos bem definidos; retorna false e preenche `error`
+// para operandos que não cabem em int ou acordes acima de GBC_MAX_CHORD_SIZE.
+inline bool assembleGBASM(const std::string& text, GbcProgram& program, std::string& error) {
+    std::vector<std::string> lines;
+    std::vector<std::pair<std::string, size_t>> labelLines; // nome, linha
+    std::istringstream input(text);
+    std::string line;
+
+    // Primeira passada: coletar instruções e labels
+    while (std::getline(input, line)) {
+        size_t comment_pos = line.find(';');
+        if (comment_pos != std::string::npos) {
+            line = line.substr(0, comment_pos);
+        }
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty()) continue;
+
+        if (line[0] == ':') {
+            labelLines.emplace_back(line.substr(1), lines.size());
+            continue;
+        }
+        lines.push_back(line);
+    }
+
+    // Índice binário de cada linha (acordes longos ocupam várias instruções)
+    std::vector<int> codeIndex(lines.size() + 1, 0);
+    for (size_t i = 0; i < lines.size(); i++) {
+        codeIndex[i + 1] = codeIndex[i] + gbcEncodedSize(lines[i]);
+    }
+
+    std::map<std::string, int> labelIndex;
+    for (const auto& entry : labelLines) {
+        int target = codeIndex[entry.second];
+        labelIndex[entry.first] = target;
+
+        // Nomes longos são encurtados só na tabela (usada pelo disassembler);
+        // o sufixo com o destino mantém nomes distintos para destinos distintos
+        std::string name = entry.first;
+        if (name.size() >= sizeof(GbcLabel::name)) {
+            name = name.substr(0, 16) + "~" + std::to_string(target);
+        }
+        GbcLabel label = {};
+        label.target = target;
+        std::strncpy(label.name, name.c_str(), sizeof(label.name) - 1);
+        program.labels.push_back(label);
+    }
+
+    // Lê um operando como a VM de texto (operator>> em int). Em overflow o
+    // stream marca failbit e satura o valor; texto não numérico vira 0.
+    bool overflow = false;
+    auto read = [&overflow](std::istream& in, int& operand) {
+        in >> operand;
+        if (in.fail() && operand != 0) overflow = true;
+    };
+
+    // Segunda passada: codificar instruções com saltos resolvidos
+    for (const auto& instruction : lines) {
+        std::istringstream iss(instruction);
+        std::string cmd;
+        iss >> cmd;
+        overflow = false;
+
+        GbcInstruction op = {};
+        int value = 0;
+
+        if (cmd == "SET_TEMPO") {
+            read(iss, value);
+            op.opcode = GBC_SET_TEMPO;
+            op.value = value;
+            program.tempo.push_back({static_cast<uint32_t>(program.code.size()), value, 0, 0});
+        } else if (cmd == "SET_TS") {
+            // Aceita "SET_TS 4 4" e "SET_TS 4/4"
+            std::string rest;
+            std::getline(iss, rest);
+            for (char& c : rest) if (c == '/') c = ' ';
+            std::istringstream ts(rest);
+            int num = 4, den = 4;
+            read(ts, num);
+            read(ts, den);
+            op.opcode = GBC_SET_TS;
+            op.a = num;
+            op.b = den;
+            program.tempo.push_back({static_cast<uint32_t>(program.code.size()), 0, op.a, op.b});
+        } else if (cmd == "TRACK") {
+            read(iss, value);
+            op.opcode = GBC_TRACK;
+            op.a = value;
+        } else if (cmd == "NOTE" || cmd == "DRUM") {
+            int first = 0, velocity = 0, duration = 0;
+            read(iss, first);
+            read(iss, velocity);
+            read(iss, duration);
+            op.opcode = cmd == "NOTE" ? GBC_NOTE : GBC_DRUM;
+            op.a = first;
+            op.b = velocity;
+            op.value = duration;
+        } else if (cmd == "CHORD") {
+            int num_notes = 0;
+            read(iss, num_notes);
+            if (num_notes > GBC_MAX_CHORD_SIZE) {
+                error = "acorde com mais de " + std::to_string(GBC_MAX_CHORD_SIZE) + " notas: " + instruction;
+                return false;
+            }
+            std::vector<int> pitches(std::max(0, num_notes));
+            for (int& pitch : pitches) {
+                read(iss, pitch);
+            }
+            int velocity = 0, duration = 0;
+            read(iss, velocity);
+            read(iss, duration);
+            if (overflow) {
+                error = "operando fora do intervalo: " + instruction;
+                return false;
+            }
+
+            // Primeiro bloco de até GBC_MAX_CHORD_NOTES notas + continuações
+            size_t pos = 0;
+            op.opcode = GBC_CHORD;
+            op.b = velocity;
+            op.value = duration;
+            do {
+                size_t chunk = std::min<size_t>(GBC_MAX_CHORD_NOTES, pitches.size() - pos);
+                op.a = chunk;
+                for (size_t i = 0; i < chunk; i++) {
+                    op.notes[i] = pitches[pos + i];
+                }
+                pos += chunk;
+                op.reserved = pos < pitches.size() ? 1 : 0;
+                program.code.push_back(op);
+
+                op = GbcInstruction();
+                op.opcode = GBC_CHORD_CONT;
+            } while (pos < pitches.size());
+            continue;
+        } else if (cmd == "WAIT") {
+            read(iss, value);
+            op.opcode = GBC_WAIT;
+            op.value = value;
+        } else if (cmd == "LOAD" || cmd == "DECJNZ") {
+            std::string reg, arg;
+            iss >> reg;
+            if (cmd == "LOAD") {
+                read(iss, value);
+            } else {
+                iss >> arg;
+            }
+            int reg_num = gbcRegister(reg);
+            if (reg_num < 0) {
+                // Registrador inválido: ignorado, como no modo texto
+                program.code.push_back(op);
+                continue;
+            }
+            op.a = reg_num;
+            if (cmd == "LOAD") {
+                op.opcode = GBC_LOAD;
+                op.value = value;
+            } else {
+                op.opcode = GBC_DECJNZ;
+                auto it = labelIndex.find(arg);
+                op.value = it != labelIndex.end() ? it->second : -1;
+            }
+        } else if (cmd == "JMP") {
+            std::string label;
+            iss >> label;
+            auto it = labelIndex.find(label);
+            op.opcode = GBC_JMP;
+            op.value = it != labelIndex.end() ? it->second : -1;
+        } else if (cmd == "HALT") {
+            op.opcode = GBC_HALT;
+        } else {
+            // Instruções não suportadas pela VM são ignoradas, como no modo texto
+            op.opcode = GBC_NOP;
+        }
+
+        if (overflow) {
+            error = "operando fora do intervalo: " + instruction;
+            return false;
+        }
+        program.code.push_back(op);
+    }
+
+    if (program.code.size() != static_cast<size_t>(codeIndex.back())) {
+        error = "tamanho de código inconsistente";
+        return false;
+    }
+    return true;
+}
+
+// Junta as notas de um CHORD e de suas continuações a partir de `index`.
+// Retorna quantas instruções o acorde ocupa.
+inline uint32_t gbcCollectChord(const GbcView& view, uint32_t index, std::vector<int>& pitches) {
+    uint32_t used = 0;
+    const GbcInstruction* op = &view.code[index];
+    while (true) {
+        pitches.insert(pitches.end(), op->notes, op->notes + op->a);
+        used++;
+        if (!op->reserved || index + used >= view.instruction_count) break;
+        op = &view.code[index + used];
+    }
+    return used;
+}
+
+inline std::string gbcChordText(const std::vector<int>& pitches, int velocity, int duration) {
+    std::string s = "CHORD " + std::to_string(pitches.size());
+    for (int pitch : pitches) {
+        s += " " + std::to_string(pitch);
+    }
+    return s + " " + std::to_string(velocity) + " " + std::to_string(duration);
+}
+
+inline std::string serializeGBC(const GbcProgram& program) {
+    GbcHeader header = {};
+    std::memcpy(header.magic, GBC_MAGIC, 4);
+    header.version = GBC_VERSION;
+    header.header_size = sizeof(GbcHeader);
+    header.tempo_count = program.tempo.size();
+    header.label_count = program.labels.size();
+    header.instruction_count = program.code.size();
+
+    std::string out;
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.append(reinterpret_cast<const char*>(program.tempo.data()), program.tempo.size() * sizeof(GbcTempoEntry));
+    out.append(reinterpret_cast<const char*>(program.labels.data()), program.labels.size() * sizeof(GbcLabel));
+    out.append(reinterpret_cast<const char*>(program.code.data()), program.code.size() * sizeof(GbcInstruction));
+    return out;
+}
+
+// Valida um container e cria uma visão sem cópia sobre `data`
+inline bool openGBC(const void* data, size_t size, GbcView& view, std::string& error) {
+    if (!isGBC(data, size)) {
+        error = "assinatura GBBC ausente";
+        return false;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const GbcHeader* header = reinterpret_cast<const GbcHeader*>(bytes);
+    if (header->version != GBC_VERSION) {
+        error = "versão " + std::to_string(header->version) + " não suportada";
+        return false;
+    }
+
+    size_t expected = header->header_size
+        + static_cast<size_t>(header->tempo_count) * sizeof(GbcTempoEntry)
+        + static_cast<size_t>(header->label_count) * sizeof(GbcLabel)
+        + static_cast<size_t>(header->instruction_count) * sizeof(GbcInstruction);
+    if (header->header_size < sizeof(GbcHeader) || header->header_size % 8 != 0) {
+        error = "tamanho de header inválido";
+        return false;
+    }
+    if (size < expected) {
+        error = "container truncado";
+        return false;
+    }
+
+    const uint8_t* cursor = bytes + header->header_size;
+    view.header = header;
+    view.tempo_count = header->tempo_count;
+    view.tempo = reinterpret_cast<const GbcTempoEntry*>(cursor);
+    cursor += header->tempo_count * sizeof(GbcTempoEntry);
+    view.label_count = header->label_count;
+    view.labels = reinterpret_cast<const GbcLabel*>(cursor);
+    cursor += header->label_count * sizeof(GbcLabel);
+    view.instruction_count = header->instruction_count;
+    view.code = reinterpret_cast<const GbcInstruction*>(cursor);
+
+    // A VM executa o array sem checagens: valida cada instrução aqui
+    int64_t count = view.instruction_count;
+    for (uint32_t i = 0; i < view.label_count; i++) {
+        int64_t target = view.labels[i].target;
+        if (target > count || (target < count && view.code[target].opcode == GBC_CHORD_CONT)) {
+            error = "label com destino fora do programa";
+            return false;
+        }
+    }
+    for (int64_t i = 0; i < count; i++) {
+        const GbcInstruction& op = view.code[i];
+        std::string at = " na instrução " + std::to_string(i);
+        if (op.opcode > GBC_CHORD_CONT) {
+            error = "opcode desconhecido" + at;
+            return false;
+        }
+        if ((op.opcode == GBC_LOAD || op.opcode == GBC_DECJNZ) && (op.a < 0 || op.a >= 4)) {
+            error = "registrador inválido" + at;
+            return false;
+        }
+        if ((op.opcode == GBC_CHORD || op.opcode == GBC_CHORD_CONT) && (op.a < 0 || op.a > GBC_MAX_CHORD_NOTES)) {
+            error = "acorde com notas demais" + at;
+            return false;
+        }
+        bool continued = (op.opcode == GBC_CHORD || op.opcode == GBC_CHORD_CONT) && op.reserved;
+        if (continued && (i + 1 >= count || view.code[i + 1].opcode != GBC_CHORD_CONT)) {
+            error = "continuação de acorde ausente" + at;
+            return false;
+        }
+        if (op.opcode == GBC_CHORD_CONT) {
+            const GbcInstruction& prev = view.code[i > 0 ? i - 1 : 0];
+            if (i == 0 || !(prev.opcode == GBC_CHORD || prev.opcode == GBC_CHORD_CONT) || !prev.reserved) {
+                error = "continuação de acorde solta" + at;
+                return false;
+            }
+        }
+        if ((op.opcode == GBC_JMP || op.opcode == GBC_DECJNZ) &&
+            (op.value < -1 || op.value > count || (op.value >= 0 && op.value < count && view.code[op.value].opcode == GBC_CHORD_CONT))) {
+            error = "destino de salto inválido" + at;
+            return false;
+        }
+    }
+    return true;
+}
+
+inline std::string gbcJumpTarget(const GbcView& view, int32_t target) {
+    for (uint32_t i = 0; i < view.label_count; i++) {
+        if (static_cast<int32_t>(view.labels[i].target) == target) {
+            return std::string(view.labels[i].name, strnlen(view.labels[i].name, sizeof(view.labels[i].name)));
+        }
+    }
+    return "?";
+}
+
+// Converte uma instrução de volta para texto GBASM
+inline std::string disassembleInstruction(const GbcInstruction& op, const GbcView& view) {
+    std::string r = "R" + std::to_string(op.a);
+    switch (op.opcode) {
+        case GBC_SET_TEMPO: return "SET_TEMPO " + std::to_string(op.value);
+        case GBC_SET_TS:    return "SET_TS " + std::to_string(op.a) + " " + std::to_string(op.b);
+        case GBC_TRACK:     return "TRACK " + std::to_string(op.a);
+        case GBC_NOTE:
+            return "NOTE " + std::to_string(op.a) + " " + std::to_string(op.b) + " " + std::to_string(op.value);
+        case GBC_DRUM:
+            return "DRUM " + std::to_string(op.a) + " " + std::to_string(op.b) + " " + std::to_string(op.value);
+        case GBC_CHORD: {
+            std::string s = "CHORD " + std::to_string(op.a);
+            for (int i = 0; i < op.a && i < GBC_MAX_CHORD_NOTES; i++) {
+                s += " " + std::to_string(op.notes[i]);
+            }
+            return s + " " + std::to_string(op.b) + " " + std::to_string(op.value);
+        }
+        case GBC_CHORD_CONT: {
+            std::string s = "CHORD_CONT " + std::to_string(op.a);
+            for (int i = 0; i < op.a && i < GBC_MAX_CHORD_NOTES; i++) {
+                s += " " + std::to_string(op.notes[i]);
+            }
+            return s;
+        }
+        case GBC_WAIT:   return "WAIT " + std::to_string(op.value);
+        case GBC_LOAD:   return "LOAD " + r + " " + std::to_string(op.value);
+        case GBC_DECJNZ: return "DECJNZ " + r + " " + gbcJumpTarget(view, op.value);
+        case GBC_JMP:    return "JMP " + gbcJumpTarget(view, op.value);
+        case GBC_HALT:   return "HALT";
+        default:         return "NOP";
+    }
+}
+
+inline std::string disassembleGBC(const GbcView& view) {
+    std::string out = "; Disassembled from GBC v" + std::to_string(GBC_VERSION) + "\n\n";
+    for (uint32_t i = 0; i <= view.instruction_count; i++) {
+        for (uint32_t l = 0; l < view.label_count; l++) {
+            if (view.labels[l].target == i) {
+                out += ":" + std::string(view.labels[l].name, strnlen(view.labels[l].name, sizeof(view.labels[l].name))) + "\n";
+            }
+        }
+        if (i >= view.instruction_count) continue;
+        const GbcInstruction& op = view.code[i];
+        if (op.opcode == GBC_CHORD) {
+            // Acorde longo: volta a ser uma linha CHORD só
+            std::vector<int> pitches;
+            gbcCollectChord(view, i, pitches);
+            out += gbcChordText(pitches, op.b, op.value) + "\n";
+        } else if (op.opcode != GBC_CHORD_CONT) {
+            out += disassembleInstruction(op, view) + "\n";
+        }
+    }
+    return out;
+}
+
+#endif // GBASM_BINARY_HPP
@@ -7,6 +7,16 @@
 #include <algorithm>
 #include <map>
 #include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "gbasm_binary.hpp"
+#include "oscillator.hpp"
+#include "effects.hpp"
+#include "resampler.hpp"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -62,14 +72,45 @@ public:
     }
 };
 
+// Arquivo mapeado em memória (somente leitura)
+class MappedFile {
+private:
+    void* mapping = MAP_FAILED;
+    size_t length = 0;
+    
+public:
+    ~MappedFile() {
+        if (mapping != MAP_FAILED) munmap(mapping, length);
+    }
+    
+    bool open(const std::string& filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0;
+        length = ok ? static_cast<size_t>(st.st_size) : 0;
+        if (ok && length > 0) {
+            mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            ok = mapping != MAP_FAILED;
+        }
+        close(fd);
+        return ok;
+    }
+    
+    const char* data() const { return mapping != MAP_FAILED ? static_cast<const char*>(mapping) : ""; }
+    size_t size() const { return length; }
+};
+
 // Evento musical agendado
 struct AudioEvent {
     int timestamp_ticks;
     int track_id;
-    std::string instruction;
+    GbcInstruction instruction;
+    std::vector<int> pitches; // CHORD: todas as notas, incluindo continuações
     
-    AudioEvent(int time, int track, std::string instr) 
-        : timestamp_ticks(time), track_id(track), instruction(instr) {}
+    AudioEvent(int time, int track, const GbcInstruction& instr, std::vector<int> chord = {}) 
+        : timestamp_ticks(time), track_id(track), instruction(instr), pitches(std::move(chord)) {}
 };
 
 // Comparador para ordenar eventos por tempo
@@ -83,9 +124,10 @@ struct EventComparator {
 class TrackSynthesizer {
 private:
     int sample_rate;
+    WavetableBank wavetables; // construído uma vez por sample rate
     
 public:
-    TrackSynthesizer(int rate = 44100) : sample_rate(rate) {}
+    TrackSynthesizer(int rate = 44100) : sample_rate(rate), wavetables(rate) {}
     
     // Gera samples para uma nota em um buffer específico
     void renderNote(std::vector<float>& buffer, int start_sample, int midi_note, int velocity, int duration_ticks, int track_type) {
@@ -102,23 +144,27 @@ public:
             buffer.resize(start_sample + num_samples, 0.0f);
         }
         
-        // Generate and mix into buffer
+        if (track_type != 0 && track_type != 1) return;
+        
+        // Bass: seno com decay exponencial; Guitar: square band-limited
+        double amplitude = (velocity / 127.0) * 0.3;
+        double decay_rate = 2.0;
+        if (track_type == 1) {
+            amplitude *= 0.5;
+            decay_rate = 1.5;
+        }
+        
+        WavetableOscillator osc(wavetables, track_type == 0 ? Waveform::Sine : Waveform::Square, frequency, sample_rate);
+        
+        // Envelope exp(-t * rate) calculado de forma incremental
+        double envelope = amplitude;
+        double decay = std::exp(-decay_rate / sample_rate);
+        
+        // Generate and mix into buffer (additive synthesis)
+        float* out = buffer.data() + start_sample;
         for (int i = 0; i < num_samples; i++) {
-            double t = static_cast<double>(i) / sample_rate;
-            double envelope, sample = 0.0;
-            double amplitude = (velocity / 127.0) * 0.3;
-            
-            if (track_type == 0) { // Bass
-                envelope = std::exp(-t * 2.0);
-                sample = amplitude * envelope * std::sin(2.0 * M_PI * frequency * t);
-            } else if (track_type == 1) { // Guitar
-                envelope = std::exp(-t * 1.5);
-                // Square wave for guitar
-                sample = amplitude * envelope * (std::sin(2.0 * M_PI * frequency * t) > 0 ? 1.0 : -1.0) * 0.5;
-            }
-            
-            // Mix into existing buffer (additive synthesis)
-            buffer[start_sample + i] += sample;
+            out[i] += static_cast<float>(envelope * osc.next());
+            envelope *= decay;
         }
     }
     
@@ -133,18 +179,26 @@ public:
             buffer.resize(start_sample + num_samples, 0.0f);
         }
         
+        // Um oscilador senoidal por nota, frequência calculada uma vez
+        std::vector<WavetableOscillator> oscillators;
+        oscillators.reserve(midi_notes.size());
+        for (int midi_note : midi_notes) {
+            double frequency = 440.0 * std::pow(2.0, (midi_note - 69) / 12.0);
+            oscillators.emplace_back(wavetables, Waveform::Sine, frequency, sample_rate);
+        }
+        
+        double envelope = (velocity / 127.0) * 0.15;
+        double decay = std::exp(-1.5 / sample_rate);
+        
+        float* out = buffer.data() + start_sample;
         for (int i = 0; i < num_samples; i++) {
-            double t = static_cast<double>(i) / sample_rate;
-            double envelope = std::exp(-t * 1.5);
-            double mixed_sample = 0.0;
-            
-            for (int midi_note : midi_notes) {
-                double frequency = 440.0 * std::pow(2.0, (midi_note - 69) / 12.0);
-                double amplitude = (velocity / 127.0) * envelope * 0.15;
-                mixed_sample += amplitude * std::sin(2.0 * M_PI * frequency * t);
+            float mixed_sample = 0.0f;
+            for (auto& osc : oscillators) {
+                mixed_sample += osc.next();
             }
             
-            buffer[start_sample + i] += mixed_sample;
+            out[i] += static_cast<float>(envelope * mixed_sample);
+            envelope *= decay;
         }
     }
     
@@ -188,131 +242,148 @@ private:
     std::vector<std::vector<float>> track_buffers; // 3 tracks: bass, guitar, drums
     TrackSynthesizer synth;
     int registers[4] = {0};
-    std::map<std::string, int> labels;
     int program_counter = 0;
     int current_time_ticks = 0;
-    int sample_rate;
+    int sample_rate;          // taxa interna de render (já sobreamostrada)
+    int output_rate;          // taxa do WAV final
+    ResamplerQuality resampler_quality = ResamplerQuality::Standard;
+    bool verbose = false;     // trace por instrução (--verbose)
+    MasterBusConfig master_bus;
     
 public:
-    MultitrackVM(int rate = 44100) : sample_rate(rate) {
+    MultitrackVM(int rate = 44100) : synth(rate), sample_rate(rate), output_rate(rate) {
         track_buffers.resize(3); // 3 tracks
     }
     
+    // Configura sends e efeitos do master bus
+    void setMasterBus(const MasterBusConfig& config) {
+        master_bus = config;
+    }
+    
+    void setVerbose(bool enabled) {
+        verbose = enabled;
+    }
+    
+    // Taxa do WAV final; se diferente da taxa de render, passa pelo resampler
+    void setOutputRate(int rate, ResamplerQuality quality) {
+        output_rate = rate;
+        resampler_quality = quality;
+    }
+    
     // Agenda um evento musical
-    void scheduleEvent(int timestamp, int track_id, const std::string& instruction) {
-        events.push_back(AudioEvent(timestamp, track_id, instruction));
-        std::cout << "  Scheduled at " << timestamp << " ticks: TRACK " << track_id << " " << instruction << std::endl;
+    void scheduleEvent(int timestamp, int track_id, const GbcInstruction& instruction, std::vector<int> pitches = {}) {
+        if (verbose) {
+            std::string text = instruction.opcode == GBC_CHORD
+                ? gbcChordText(pitches, instruction.b, instruction.value)
+                : disassembleInstruction(instruction, GbcView());
+            std::cout << "  Scheduled at " << timestamp << " ticks: TRACK " << track_id << " " << text << '\n';
+        }
+        events.push_back(AudioEvent(timestamp, track_id, instruction, std::move(pitches)));
     }
     
-    // Processa arquivo GBASM e agenda eventos
+    // Carrega um programa GBASM (texto ou container binário .gbc) e agenda eventos
     bool loadGBASM(const std::string& filename) {
-        std::ifstream file(filename);
-        if (!file) return false;
-        
-        std::vector<std::string> instructions;
-        std::string line;
-        int line_number = 0;
-        
-        // Primeira passada: coletar instruções e labels
-        while (std::getline(file, line)) {
-            line_number++;
-            
-            // Remove comentários
-            size_t comment_pos = line.find(';');
-            if (comment_pos != std::string::npos) {
-                line = line.substr(0, comment_pos);
+        MappedFile file;
+        if (!file.open(filename)) return false;
+        
+        if (isGBC(file.data(), file.size())) {
+            // Container binário: executa direto da memória mapeada
+            GbcView view;
+            std::string error;
+            if (!openGBC(file.data(), file.size(), view, error)) {
+                std::cerr << "Invalid GBC container: " << error << std::endl;
+                return false;
             }
-            
-            // Trim whitespace
-            line.erase(0, line.find_first_not_of(" \t"));
-            line.erase(line.find_last_not_of(" \t") + 1);
-            
-            if (line.empty()) continue;
-            
-            // Check for labels
-            if (line[0] == ':') {
-                std::string label = line.substr(1);
-                labels[label] = instructions.size();
-                std::cout << "Label " << label << " at instruction " << instructions.size() << std::endl;
-                continue;
+            std::cout << "Loaded GBC container: " << view.instruction_count << " instructions" << std::endl;
+            runProgram(view);
+        } else {
+            // Texto GBASM: monta uma vez, depois executa o mesmo array
+            GbcProgram program;
+            std::string error;
+            if (!assembleGBASM(std::string(file.data(), file.size()), program, error)) {
+                std::cerr << "GBASM error: " << error << std::endl;
+                return false;
             }
-            
-            instructions.push_back(line);
+            runProgram(viewOf(program));
+        }
+        
+        // Ordenar eventos por tempo
+        std::sort(events.begin(), events.end(), EventComparator());
+        
+        std::cout << "\nScheduled " << events.size() << " audio events" << std::endl;
+        return true;
+    }
+    
+    // Executa o array de instruções e agenda eventos
+    void runProgram(const GbcView& program) {
+        for (uint32_t i = 0; verbose && i < program.label_count; i++) {
+            std::cout << "Label " << gbcJumpTarget(program, program.labels[i].target)
+                      << " at instruction " << program.labels[i].target << '\n';
         }
         
-        // Segunda passada: executar e agendar eventos
         program_counter = 0;
         current_time_ticks = 0;
         
-        while (program_counter < instructions.size()) {
-            if (!executeInstruction(instructions[program_counter])) {
+        while (program_counter < static_cast<int>(program.instruction_count)) {
+            if (!executeInstruction(program.code[program_counter], program)) {
                 break;
             }
             program_counter++;
         }
-        
-        // Ordenar eventos por tempo
-        std::sort(events.begin(), events.end(), EventComparator());
-        
-        std::cout << "\nScheduled " << events.size() << " audio events" << std::endl;
-        return true;
     }
     
     // Executa uma instrução GBASM
-    bool executeInstruction(const std::string& instruction) {
-        std::istringstream iss(instruction);
-        std::string cmd;
-        iss >> cmd;
-        
-        if (cmd == "SET_TEMPO" || cmd == "SET_TS") {
-            std::cout << "  " << instruction << std::endl;
-        } else if (cmd == "TRACK") {
-            // TRACK é implícito nos eventos agendados
-        } else if (cmd == "NOTE") {
-            int pitch, velocity, duration;
-            iss >> pitch >> velocity >> duration;
-            scheduleEvent(current_time_ticks, 0, instruction); // Bass = track 0
-        } else if (cmd == "CHORD") {
-            scheduleEvent(current_time_ticks, 1, instruction); // Guitar = track 1
-        } else if (cmd == "DRUM") {
-            scheduleEvent(current_time_ticks, 2, instruction); // Drums = track 2
-        } else if (cmd == "WAIT") {
-            int duration;
-            iss >> duration;
-            current_time_ticks += duration;
-            std::cout << "  WAIT " << duration << " (now at " << current_time_ticks << " ticks)" << std::endl;
-        } else if (cmd == "LOAD") {
-            std::string reg;
-            int value;
-            iss >> reg >> value;
-            int reg_num = reg[1] - '0';
-            if (reg_num >= 0 && reg_num < 4) {
-                registers[reg_num] = value;
-                std::cout << "  LOAD " << reg << " " << value << std::endl;
+    bool executeInstruction(const GbcInstruction& instruction, const GbcView& program) {
+        switch (instruction.opcode) {
+            case GBC_SET_TEMPO:
+            case GBC_SET_TS:
+                if (verbose) std::cout << "  " << disassembleInstruction(instruction, program) << '\n';
+                break;
+            case GBC_TRACK:
+                // TRACK é implícito nos eventos agendados
+                break;
+            case GBC_NOTE:
+                scheduleEvent(current_time_ticks, 0, instruction); // Bass = track 0
+                break;
+            case GBC_CHORD: {
+                std::vector<int> pitches;
+                program_counter += gbcCollectChord(program, program_counter, pitches) - 1;
+                scheduleEvent(current_time_ticks, 1, instruction, std::move(pitches)); // Guitar = track 1
+                break;
             }
-        } else if (cmd == "DECJNZ") {
-            std::string reg, label;
-            iss >> reg >> label;
-            int reg_num = reg[1] - '0';
-            if (reg_num >= 0 && reg_num < 4) {
-                registers[reg_num]--;
-                std::cout << "  DECJNZ " << reg << " " << label << " (" << reg << "=" << registers[reg_num] << ")" << std::endl;
-                if (registers[reg_num] > 0) {
-                    if (labels.find(label) != labels.end()) {
-                        program_counter = labels[label] - 1; // -1 porque será incrementado
-                    }
+            case GBC_DRUM:
+                scheduleEvent(current_time_ticks, 2, instruction); // Drums = track 2
+                break;
+            case GBC_WAIT:
+                current_time_ticks += instruction.value;
+                if (verbose) std::cout << "  WAIT " << instruction.value << " (now at " << current_time_ticks << " ticks)\n";
+                break;
+            case GBC_LOAD:
+                registers[instruction.a] = instruction.value;
+                if (verbose) std::cout << "  LOAD R" << int(instruction.a) << " " << instruction.value << '\n';
+                break;
+            case GBC_DECJNZ: {
+                int& reg = registers[instruction.a];
+                reg--;
+                if (verbose) {
+                    std::cout << "  " << disassembleInstruction(instruction, program) << " (R" << int(instruction.a) << "=" << reg << ")\n";
                 }
+                if (reg > 0 && instruction.value >= 0) {
+                    program_counter = instruction.value - 1; // -1 porque será incrementado
+                }
+                break;
             }
-        } else if (cmd == "JMP") {
-            std::string label;
-            iss >> label;
-            if (labels.find(label) != labels.end()) {
-                program_counter = labels[label] - 1;
-                std::cout << "  JMP " << label << std::endl;
-            }
-        } else if (cmd == "HALT") {
-            std::cout << "  HALT" << std::endl;
-            return false;
+            case GBC_JMP:
+                if (instruction.value >= 0) {
+                    program_counter = instruction.value - 1;
+                    if (verbose) std::cout << "  " << disassembleInstruction(instruction, program) << '\n';
+                }
+                break;
+            case GBC_HALT:
+                if (verbose) std::cout << "  HALT\n";
+                return false;
+            default:
+                break;
         }
         
         return true;
@@ -347,62 +418,58 @@ public:
         // Renderizar cada evento na track correspondente
         for (const auto& event : events) {
             int start_sample = static_cast<int>((event.timestamp_ticks / ticks_per_second) * sample_rate);
+            const GbcInstruction& op = event.instruction;
             
-            std::istringstream iss(event.instruction);
-            std::string cmd;
-            iss >> cmd;
-            
-            if (cmd == "NOTE") {
-                int pitch, velocity, duration;
-                iss >> pitch >> velocity >> duration;
-                synth.renderNote(track_buffers[event.track_id], start_sample, pitch, velocity, duration, event.track_id);
-            } else if (cmd == "CHORD") {
-                int num_notes;
-                iss >> num_notes;
-                std::vector<int> pitches;
-                for (int i = 0; i < num_notes; i++) {
-                    int pitch;
-                    iss >> pitch;
-                    pitches.push_back(pitch);
-                }
-                int velocity, duration;
-                iss >> velocity >> duration;
-                synth.renderChord(track_buffers[event.track_id], start_sample, pitches, velocity, duration);
-            } else if (cmd == "DRUM") {
-                int drum_type, velocity, duration;
-                iss >> drum_type >> velocity >> duration;
-                synth.renderDrum(track_buffers[event.track_id], start_sample, drum_type, velocity, duration);
+            if (op.opcode == GBC_NOTE) {
+                synth.renderNote(track_buffers[event.track_id], start_sample, op.a, op.b, op.value, event.track_id);
+            } else if (op.opcode == GBC_CHORD) {
+                synth.renderChord(track_buffers[event.track_id], start_sample, event.pitches, op.b, op.value);
+            } else if (op.opcode == GBC_DRUM) {
+                synth.renderDrum(track_buffers[event.track_id], start_sample, op.a, op.b, op.value);
             }
         }
     }
     
-    // Mixa todas as tracks em um buffer master
+    // Mixa todas as tracks no master bus (sends, reverb, delay, limiter)
     void mixToWAV(SimpleWAVWriter& writer) {
         if (track_buffers.empty()) return;
         
+        // Decimação do render sobreamostrado e/ou conversão de taxa, por track
+        // e antes do master bus: reverb e delay são lineares (não ganham nada
+        // com oversampling) e a convolução custa ~taxa², então o bus roda na
+        // taxa de saída. O limiter fica por último e garante o teto no WAV.
+        if (output_rate != sample_rate) {
+            for (auto& track : track_buffers) {
+                PolyphaseResampler resampler(sample_rate, output_rate, resampler_quality);
+                std::vector<float> converted;
+                converted.reserve(track.size() * resampler.upFactor() / resampler.downFactor() + 1);
+                resampler.process(track.data(), track.size(), converted);
+                resampler.finish(converted);
+                track.swap(converted);
+            }
+            std::cout << "Resampled tracks " << sample_rate << " Hz -> " << output_rate << " Hz" << std::endl;
+        }
+        
         // Encontrar o tamanho máximo entre todas as tracks
         size_t max_size = 0;
         for (const auto& track : track_buffers) {
             max_size = std::max(max_size, track.size());
         }
         
+        MasterBus bus(master_bus, output_rate);
+        size_t total = max_size + bus.tailSamples();
+        size_t latency = bus.latency();
+        
         std::cout << "Mixing " << track_buffers.size() << " tracks with " << max_size << " samples each..." << std::endl;
         
-        // Mix tracks
-        for (size_t i = 0; i < max_size; i++) {
-            float mixed_sample = 0.0f;
-            
-            // Somar todas as tracks
-            for (const auto& track : track_buffers) {
-                if (i < track.size()) {
-                    mixed_sample += track[i];
-                }
-            }
+        // Processa em blocos; descarta a latência do limiter no início
+        float block[MasterBus::BLOCK_SIZE];
+        for (size_t offset = 0; offset < total + latency; offset += MasterBus::BLOCK_SIZE) {
+            int count = static_cast<int>(std::min<size_t>(MasterBus::BLOCK_SIZE, total + latency - offset));
+            bus.process(track_buffers, offset, count, block);
             
-            // Aplicar compressão suave para evitar clipping
-            mixed_sample = std::tanh(mixed_sample * 0.7) * 0.8;
-            
-            writer.addSample(mixed_sample);
+            int skip = offset >= latency ? 0 : static_cast<int>(std::min<size_t>(count, latency - offset));
+            for (int i = skip; i < count; i++) writer.addSample(block[i]);
         }
     }
     
@@ -418,7 +485,7 @@ public:
         
         renderTracks();
         
-        SimpleWAVWriter writer(sample_rate);
+        SimpleWAVWriter writer(output_rate);
         mixToWAV(writer);
         
         if (!writer.writeWAV(output_file)) {
@@ -433,16 +500,136 @@ public:
     }
 };
 
+// Conversões checadas para as opções: o texto inteiro precisa ser um número
+static bool parseNumber(const std::string& text, double& value) {
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0' && errno == 0 && std::isfinite(value);
+}
+
+static bool parseNumber(const std::string& text, int& value) {
+    char* end = nullptr;
+    errno = 0;
+    long parsed = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || errno != 0 || parsed < INT32_MIN || parsed > INT32_MAX) return false;
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+// Faixa aceita por --rate/--render-rate (o render ainda multiplica por --oversample)
+static const int MIN_SAMPLE_RATE = 8000;
+static const int MAX_SAMPLE_RATE = 384000;
+
+// MS[:FEEDBACK[:MIX]]
+static bool parseDelay(const std::string& text, MasterBusConfig& bus) {
+    std::vector<std::string> fields;
+    std::istringstream iss(text);
+    std::string field;
+    while (std::getline(iss, field, ':')) fields.push_back(field);
+    if (fields.empty() || fields.size() > 3) return false;
+
+    double ms = 0.0, feedback = bus.delay_feedback, mix = bus.delay_mix;
+    if (!parseNumber(fields[0], ms)) return false;
+    if (fields.size() > 1 && !parseNumber(fields[1], feedback)) return false;
+    if (fields.size() > 2 && !parseNumber(fields[2], mix)) return false;
+    // Feedback >= 1 nunca decai; o tamanho da linha é limitado a 10 s
+    if (ms < 0.0 || ms > 10000.0 || feedback < 0.0 || feedback >= 1.0 || mix < 0.0 || mix > 1.0) return false;
+
+    bus.delay_ms = ms;
+    bus.delay_feedback = static_cast<float>(feedback);
+    bus.delay_mix = static_cast<float>(mix);
+    return true;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc != 4 || std::string(argv[2]) != "-o") {
-        std::cerr << "Usage: " << argv[0] << " input.gbasm -o output.wav" << std::endl;
+    if (argc < 4 || std::string(argv[2]) != "-o") {
+        std::cerr << "Usage: " << argv[0] << " <input.gbasm|input.gbc> -o output.wav [options]" << std::endl;
+        std::cerr << "Options:" << std::endl;
+        std::cerr << "  --send TRACK=AMOUNT      reverb send for track 0/1/2 (0.0-1.0)" << std::endl;
+        std::cerr << "  --ir FILE.wav            impulse response (default: generated)" << std::endl;
+        std::cerr << "  --reverb-time SECONDS    RT60 of the generated impulse response" << std::endl;
+        std::cerr << "  --delay MS[:FEEDBACK[:MIX]]  master delay" << std::endl;
+        std::cerr << "  --rate HZ                output sample rate, 8000-384000 (default 44100)" << std::endl;
+        std::cerr << "  --render-rate HZ         synthesis rate before oversampling, 8000-384000 (default: output rate)" << std::endl;
+        std::cerr << "  --oversample 1|2|4       oversampled internal rendering" << std::endl;
+        std::cerr << "  --quality fast|standard|high  resampler quality" << std::endl;
+        std::cerr << "  --verbose                trace every executed instruction" << std::endl;
         return 1;
     }
     
     std::string input_file = argv[1];
     std::string output_file = argv[3];
     
-    MultitrackVM vm;
+    MasterBusConfig bus;
+    int rate = 44100, render_rate = 0, oversample = 1;
+    ResamplerQuality quality = ResamplerQuality::Standard;
+    bool verbose = false;
+    for (int i = 4; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--verbose") {
+            verbose = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << option << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        
+        if (option == "--send") {
+            size_t eq = value.find('=');
+            int track = -1;
+            double amount = -1.0;
+            if (eq == std::string::npos || !parseNumber(value.substr(0, eq), track) ||
+                !parseNumber(value.substr(eq + 1), amount) ||
+                track < 0 || track >= static_cast<int>(bus.sends.size()) || amount < 0.0 || amount > 1.0) {
+                std::cerr << "Invalid --send " << value << std::endl;
+                return 1;
+            }
+            bus.sends[track] = static_cast<float>(amount);
+        } else if (option == "--ir") {
+            bus.ir_file = value;
+        } else if (option == "--reverb-time") {
+            // IR gerada tem sample_rate * RT60 amostras: limita a 30 s
+            if (!parseNumber(value, bus.reverb_time) || bus.reverb_time <= 0.0 || bus.reverb_time > 30.0) {
+                std::cerr << "Invalid --reverb-time " << value << std::endl;
+                return 1;
+            }
+        } else if (option == "--delay") {
+            if (!parseDelay(value, bus)) {
+                std::cerr << "Invalid --delay " << value << " (use MS[:FEEDBACK[:MIX]])" << std::endl;
+                return 1;
+            }
+        } else if (option == "--rate" || option == "--render-rate") {
+            int& target = option == "--rate" ? rate : render_rate;
+            if (!parseNumber(value, target) || target < MIN_SAMPLE_RATE || target > MAX_SAMPLE_RATE) {
+                std::cerr << "Invalid " << option << " " << value << " (use " << MIN_SAMPLE_RATE
+                          << "-" << MAX_SAMPLE_RATE << " Hz)" << std::endl;
+                return 1;
+            }
+        } else if (option == "--oversample") {
+            if (!parseNumber(value, oversample) || (oversample != 1 && oversample != 2 && oversample != 4)) {
+                std::cerr << "Invalid --oversample " << value << " (use 1, 2 or 4)" << std::endl;
+                return 1;
+            }
+        } else if (option == "--quality") {
+            if (!parseResamplerQuality(value, quality)) {
+                std::cerr << "Invalid --quality " << value << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+    
+    if (render_rate <= 0) render_rate = rate;
+    
+    MultitrackVM vm(render_rate * oversample);
+    vm.setOutputRate(rate, quality);
+    vm.setMasterBus(bus);
+    vm.setVerbose(verbose);
     if (!vm.execute(input_file, output_file)) {
         return 1;
     }
@@ -0,0 +1,115 @@
+#ifndef OSCILLATOR_HPP
+#define OSCILLATOR_HPP
+
+// Banco de wavetables band-limited (sine, square, saw) com uma tabela por
+// oitava. Cada tabela só contém harmônicos abaixo de Nyquist para a nota
+// mais aguda da sua oitava, então a reprodução não gera aliasing.
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+enum class Waveform { Sine = 0, Square = 1, Saw = 2 };
+
+class WavetableBank {
+public:
+    static const int TABLE_SIZE = 2048;
+    static const int NUM_WAVEFORMS = 3;
+    static const int NUM_OCTAVES = 11;           // cobre MIDI 0..127
+    static constexpr double BASE_FREQUENCY = 8.175798915643707; // MIDI 0
+
+    explicit WavetableBank(int sample_rate) {
+        // TABLE_SIZE + 1: amostra de guarda para a interpolação linear
+        tables.assign(NUM_WAVEFORMS * NUM_OCTAVES * (TABLE_SIZE + 1), 0.0f);
+
+        // Seno de referência: sin(2*pi*h*i/N) = sine[(h*i) % N]
+        std::vector<double> sine(TABLE_SIZE);
+        for (int i = 0; i < TABLE_SIZE; i++) {
+            sine[i] = std::sin(2.0 * M_PI * i / TABLE_SIZE);
+        }
+
+        double nyquist = sample_rate / 2.0;
+        std::vector<double> acc(TABLE_SIZE);
+
+        for (int octave = 0; octave < NUM_OCTAVES; octave++) {
+            double top_frequency = BASE_FREQUENCY * std::pow(2.0, octave + 1);
+            int harmonics = static_cast<int>(nyquist / top_frequency);
+            harmonics = std::max(1, std::min(harmonics, TABLE_SIZE / 2 - 1));
+
+            for (int w = 0; w < NUM_WAVEFORMS; w++) {
+                std::fill(acc.begin(), acc.end(), 0.0);
+
+                for (int h = 1; h <= harmonics; h++) {
+                    double gain;
+                    if (w == static_cast<int>(Waveform::Sine)) {
+                        if (h > 1) break;
+                        gain = 1.0;
+                    } else if (w == static_cast<int>(Waveform::Square)) {
+                        if (h % 2 == 0) continue;
+                        gain = 1.0 / h;
+                    } else {
+                        gain = (h % 2 ? 1.0 : -1.0) / h;
+                    }
+
+                    for (int i = 0; i < TABLE_SIZE; i++) {
+                        acc[i] += gain * sine[(static_cast<long>(h) * i) % TABLE_SIZE];
+                    }
+                }
+
+                // Normaliza para pico 1.0
+                double peak = 0.0;
+                for (double v : acc) peak = std::max(peak, std::fabs(v));
+                if (peak == 0.0) peak = 1.0;
+
+                float* table = &tables[index(static_cast<Waveform>(w), octave)];
+                for (int i = 0; i < TABLE_SIZE; i++) {
+                    table[i] = static_cast<float>(acc[i] / peak);
+                }
+                table[TABLE_SIZE] = table[0];
+            }
+        }
+    }
+
+    // Tabela adequada para tocar `frequency` sem aliasing
+    const float* table(Waveform waveform, double frequency) const {
+        int octave = static_cast<int>(std::floor(std::log2(frequency / BASE_FREQUENCY)));
+        octave = std::max(0, std::min(octave, NUM_OCTAVES - 1));
+        return &tables[index(waveform, octave)];
+    }
+
+private:
+    std::vector<float> tables;
+
+    static size_t index(Waveform waveform, int octave) {
+        return (static_cast<size_t>(waveform) * NUM_OCTAVES + octave) * (TABLE_SIZE + 1);
+    }
+};
+
+// Oscilador por incremento de fase com interpolação linear
+class WavetableOscillator {
+private:
+    const float* table;
+    double phase = 0.0;
+    double increment;
+
+public:
+    WavetableOscillator(const WavetableBank& bank, Waveform waveform, double frequency, int sample_rate)
+        : table(bank.table(waveform, frequency)),
+          increment(frequency * WavetableBank::TABLE_SIZE / sample_rate) {}
+
+    float next() {
+        int i = static_cast<int>(phase);
+        float frac = static_cast<float>(phase - i);
+        float sample = table[i] + frac * (table[i + 1] - table[i]);
+
+        phase += increment;
+        while (phase >= WavetableBank::TABLE_SIZE) phase -= WavetableBank::TABLE_SIZE;
+        return sample;
+    }
+};
+
+#endif // OSCILLATOR_HPP
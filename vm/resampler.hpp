@@ -0,0 +1,199 @@
+#ifndef RESAMPLER_HPP
+#define RESAMPLER_HPP
+
+// Conversor de sample rate polifásico racional (L/M) com FIR windowed-sinc
+// (janela de Kaiser). Cobre decimação do render sobreamostrado (2x/4x) e
+// conversão para taxas arbitrárias (44.1k -> 48k, 96k, ...) em um só estágio.
+// Com L acima de MAX_PHASES a tabela guarda só MAX_PHASES fases e interpola
+// linearmente entre fases vizinhas; o tempo continua exato (L/M racional).
+// O produto escalar de cada fase é vetorizado (AVX/SSE quando disponível).
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__AVX__) || defined(__SSE__)
+#include <immintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+enum class ResamplerQuality { Fast, Standard, High };
+
+inline bool parseResamplerQuality(const std::string& name, ResamplerQuality& quality) {
+    if (name == "fast") quality = ResamplerQuality::Fast;
+    else if (name == "standard") quality = ResamplerQuality::Standard;
+    else if (name == "high") quality = ResamplerQuality::High;
+    else return false;
+    return true;
+}
+
+class PolyphaseResampler {
+public:
+    static constexpr int MAX_PHASES = 512;
+
+private:
+    int up;              // L
+    int down;            // M
+    int phases;          // fases na tabela: L, ou MAX_PHASES com interpolação
+    int taps;            // coeficientes por fase (múltiplo de 8)
+    int64_t delay;       // atraso de grupo no domínio sobreamostrado (x L)
+    std::vector<float> coefficients; // [fase][tap], taps invertidos, phases+1 fases
+    std::vector<float> history;
+    int64_t history_start;  // índice absoluto de history[0]
+    int64_t produced = 0;
+    int64_t consumed = 0;
+
+    static double besselI0(double x) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 50; k++) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < 1e-12 * sum) break;
+        }
+        return sum;
+    }
+
+    static float dot(const float* a, const float* b, int n) {
+        int i = 0;
+#if defined(__AVX__)
+        __m256 acc = _mm256_setzero_ps();
+        for (; i + 8 <= n; i += 8) {
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        }
+        __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+#elif defined(__SSE__)
+        __m128 sum4 = _mm_setzero_ps();
+        for (; i + 4 <= n; i += 4) {
+            sum4 = _mm_add_ps(sum4, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+#endif
+        float result = 0.0f;
+#if defined(__AVX__) || defined(__SSE__)
+        float lanes[4];
+        _mm_storeu_ps(lanes, sum4);
+        result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+        for (; i < n; i++) {
+            result += a[i] * b[i];
+        }
+        return result;
+    }
+
+public:
+    PolyphaseResampler(int input_rate, int output_rate, ResamplerQuality quality = ResamplerQuality::Standard) {
+        int64_t a = input_rate, b = output_rate;
+        while (b != 0) { int64_t t = a % b; a = b; b = t; }
+        up = static_cast<int>(output_rate / a);
+        down = static_cast<int>(input_rate / a);
+
+        double rolloff, beta;
+        switch (quality) {
+            case ResamplerQuality::Fast:     taps = 16; rolloff = 0.85; beta = 6.0;  break;
+            case ResamplerQuality::High:     taps = 64; rolloff = 0.95; beta = 10.0; break;
+            default:                         taps = 32; rolloff = 0.90; beta = 8.0;  break;
+        }
+
+        // Na decimação o corte cai para Nyquist da saída: o filtro precisa
+        // de taps * M/L coeficientes por fase (múltiplo de 8 para o SIMD)
+        // para manter a mesma banda de transição relativa
+        if (down > up) {
+            int64_t scaled = (static_cast<int64_t>(taps) * down + up - 1) / up;
+            taps = static_cast<int>((scaled + 7) / 8 * 8);
+        }
+
+        // Razões com L enorme (ex.: 1536000 -> 383999) teriam uma tabela de
+        // taps * L coeficientes: limita a MAX_PHASES e interpola
+        phases = std::min(up, MAX_PHASES);
+
+        // Protótipo passa-baixa na taxa sobreamostrada (input * phases)
+        int length = taps * phases;
+        double cutoff = 0.5 * rolloff / std::max(up, down) * (static_cast<double>(up) / phases); // ciclos/amostra
+        // Centro inteiro: o atraso de grupo vira um número exato de amostras
+        int center_index = length / 2;
+        delay = static_cast<int64_t>(taps / 2) * up;
+        double center = static_cast<double>(center_index);
+        double window_norm = besselI0(beta);
+        std::vector<double> prototype(length);
+        for (int i = 0; i < length; i++) {
+            double x = i - center;
+            double sinc = x == 0.0 ? 1.0 : std::sin(2.0 * M_PI * cutoff * x) / (2.0 * M_PI * cutoff * x);
+            double r = x / center;
+            double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / window_norm;
+            prototype[i] = 2.0 * cutoff * sinc * window * phases;
+        }
+
+        // Fase p usa prototype[p + k*phases]; guardada invertida para que o
+        // produto escalar percorra o histórico em ordem crescente. A fase
+        // extra (p = phases) é o vizinho direito da última na interpolação.
+        coefficients.assign(static_cast<size_t>(phases + 1) * taps, 0.0f);
+        for (int p = 0; p <= phases; p++) {
+            for (int k = 0; k < taps; k++) {
+                int index = p + k * phases;
+                coefficients[static_cast<size_t>(p) * taps + (taps - 1 - k)] =
+                    index < length ? static_cast<float>(prototype[index]) : 0.0f;
+            }
+        }
+
+        history.assign(taps - 1, 0.0f);
+        history_start = -(taps - 1);
+    }
+
+    int upFactor() const { return up; }
+    int downFactor() const { return down; }
+
+    // Consome `count` amostras e acrescenta as saídas disponíveis em `out`
+    void process(const float* input, size_t count, std::vector<float>& out) {
+        history.insert(history.end(), input, input + count);
+        consumed += count;
+        drain(out, INT64_MAX);
+    }
+
+    // Esvazia o filtro; total de saídas = ceil(entradas * L / M)
+    void finish(std::vector<float>& out) {
+        int64_t target = (consumed * up + down - 1) / down;
+        history.insert(history.end(), taps, 0.0f);
+        drain(out, target);
+    }
+
+private:
+    void drain(std::vector<float>& out, int64_t limit) {
+        int64_t available_end = history_start + static_cast<int64_t>(history.size());
+        while (produced < limit) {
+            int64_t t = produced * down + delay;
+            int64_t base = t / up;
+            if (base >= available_end) break;
+
+            int64_t remainder = t % up;
+            const float* x = &history[base - (taps - 1) - history_start];
+            if (phases == up) {
+                const float* h = &coefficients[static_cast<size_t>(remainder) * taps];
+                out.push_back(dot(h, x, taps));
+            } else {
+                // Posição fracionária entre duas fases da tabela
+                int64_t position = remainder * phases;
+                size_t phase = static_cast<size_t>(position / up);
+                float frac = static_cast<float>(position % up) / up;
+                const float* h = &coefficients[phase * taps];
+                float y0 = dot(h, x, taps);
+                float y1 = dot(h + taps, x, taps);
+                out.push_back(y0 + frac * (y1 - y0));
+            }
+            produced++;
+        }
+
+        // Descarta o histórico que nenhuma saída futura vai usar
+        int64_t next_base = (produced * down + delay) / up;
+        int64_t keep_from = std::min(next_base - (taps - 1), available_end);
+        if (keep_from > history_start) {
+            history.erase(history.begin(), history.begin() + (keep_from - history_start));
+            history_start = keep_from;
+        }
+    }
+};
+
+#endif // RESAMPLER_HPP